@@ -294,6 +294,10 @@ static inline int64_t fileSize(const char* name) {
 	return static_cast<int64_t>(f.tellg() - begin_pos);
 }
 
+// Defined toward the end of this file; declared here so Ebwt member
+// functions can use it
+void readEbwtRefnames(FILE* fin, EList<string>& refnames);
+
 /**
  * Encapsulates a location in the bwt text in terms of the side it
  * occurs in and its offset within the side.
@@ -1181,6 +1185,20 @@ public:
 	bool        sanityCheck() const  { return _sanity; }
 	EList<string>& refnames()        { return _refnames; }
 	bool        fw() const           { return fw_; }
+
+	/**
+	 * Ensure _refnames is populated, reading the names from the
+	 * already-open primary index stream if necessary.  The constructor
+	 * stops after the header, which ends before the name section, so
+	 * callers that only need the header plus names can use this
+	 * instead of re-opening the file with readEbwtRefnames(string&).
+	 */
+	EList<string>& loadRefnames() {
+		if(_refnames.empty() && _in1 != NULL) {
+			readEbwtRefnames(_in1, _refnames);
+		}
+		return _refnames;
+	}
 #ifdef POPCNT_CAPABILITY 
     bool _usePOPCNTinstruction; 
 #endif 
@@ -2441,6 +2459,58 @@ private:
 	}
 };
 
+/**
+ * Translates monotonically increasing joined-text offsets to
+ * (reference, offset, length) triples by walking the sorted rstarts
+ * fragment list one segment at a time.  Equivalent to calling
+ * Ebwt::joinedToTextOff(1, off, ...) on a forward index for each
+ * offset in turn, but the per-offset binary search collapses to an
+ * occasional segment advance, O(N + R) over a whole pass instead of
+ * O(N log R).  The index's rstarts must be loaded.
+ */
+class JoinedCursor {
+public:
+	JoinedCursor(const Ebwt& ebwt) :
+		ebwt_(ebwt),
+		elt_(0),
+		upper_(0)
+	{
+		assert(ebwt.rstarts() != NULL);
+		assert(ebwt.fw());
+		upper_ = fragUpper(0);
+	}
+
+	/**
+	 * Resolve joined offset 'off' (>= any previously resolved offset)
+	 * to a reference index, offset into the reference and reference
+	 * length; mirrors joinedToTextOff's qlen==1 behavior, where a
+	 * 1-base query can never straddle a fragment boundary.
+	 */
+	void resolve(TIndexOffU off, TIndexOffU& tidx, TIndexOffU& textoff, TIndexOffU& tlen) {
+		while(off >= upper_ && elt_ < ebwt_.nFrag()-1) {
+			elt_++;
+			upper_ = fragUpper(elt_);
+		}
+		const TIndexOffU* rs = ebwt_.rstarts() + elt_*3;
+		assert_geq(off, rs[0]);
+		assert_lt(off, upper_);
+		tidx = rs[1];
+		textoff = (off - rs[0]) + rs[2];
+		tlen = ebwt_.plen()[tidx];
+	}
+
+private:
+	/// Exclusive upper joined offset of fragment 'elt'
+	TIndexOffU fragUpper(TIndexOffU elt) const {
+		if(elt == ebwt_.nFrag()-1) return ebwt_.eh().len();
+		return ebwt_.rstarts()[(elt+1)*3];
+	}
+
+	const Ebwt& ebwt_;
+	TIndexOffU elt_;
+	TIndexOffU upper_;
+};
+
 /**
  * Read reference names from an input stream 'in' for an Ebwt primary
  * file and store them in 'refnames'.
@@ -21,9 +21,17 @@
 
 #include <string>
 #include <iostream>
+#include <vector>
+#include <charconv>
+#include <cstdlib>
+#include <memory>
 #include <getopt.h>
 #include <stdexcept>
 
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
 #include "assert_helpers.h"
 #include "endian_swap.h"
 #include "bt2_idx.h"
@@ -64,57 +72,54 @@ static struct option long_options[] = {
  * Print a summary usage message to the provided output stream.
  */
 static void printUsage(ostream& out) {
-	out << "Bowtie 2 version " << string(BOWTIE2_VERSION).c_str() << " by Ben Langmead (langmea@cs.jhu.edu, www.cs.jhu.edu/~langmea)" << endl;
+	out << "Bowtie 2 version " << string(BOWTIE2_VERSION).c_str() << " by Ben Langmead (langmea@cs.jhu.edu, www.cs.jhu.edu/~langmea)" << "\n";
 	out
-	<< "Usage: bowtie2-inspect [options]* <bt2_base>" << endl
-	<< "  <bt2_base>         bt2 filename minus trailing .1." + gEbwt_ext + "/.2." + gEbwt_ext << endl
-	<< endl
-	<< "  By default, prints FASTA records of the indexed nucleotide sequences to" << endl
-	<< "  standard out.  With -n, just prints names.  With -s, just prints a summary of" << endl
-	<< "  the index parameters and sequences." << endl
-	<< endl
-	<< "Options:" << endl;
+	<< "Usage: bowtie2-inspect [options]* <bt2_base>" << "\n"
+	<< "  <bt2_base>         bt2 filename minus trailing .1." + gEbwt_ext + "/.2." + gEbwt_ext << "\n"
+	<< "\n"
+	<< "  By default, prints FASTA records of the indexed nucleotide sequences to" << "\n"
+	<< "  standard out.  With -n, just prints names.  With -s, just prints a summary of" << "\n"
+	<< "  the index parameters and sequences." << "\n"
+	<< "\n"
+	<< "Options:" << "\n";
 	if(wrapper == "basic-0") {
-		out << "  --large-index      force inspection of the 'large' index, even if a" << endl
-			<< "                     'small' one is present." << endl;
+		out << "  --large-index      force inspection of the 'large' index, even if a" << "\n"
+			<< "                     'small' one is present." << "\n";
 	}
-	out << "  -a/--across <int>  Number of characters across in FASTA output (default: 60)" << endl
-	<< "  -n/--names         Print reference sequence names only" << endl
-	<< "  -s/--summary       Print summary incl. ref names, lengths, index properties" << endl
-	<< "  -v/--verbose       Verbose output (for debugging)" << endl
-	<< "  -h/--help          print detailed description of tool and its options" << endl
-	<< "  --help             print this usage message" << endl
+	out << "  -a/--across <int>  Number of characters across in FASTA output (default: 60)" << "\n"
+	<< "  -n/--names         Print reference sequence names only" << "\n"
+	<< "  -s/--summary       Print summary incl. ref names, lengths, index properties" << "\n"
+	<< "  -v/--verbose       Verbose output (for debugging)" << "\n"
+	<< "  -h/--help          print detailed description of tool and its options" << "\n"
+	<< "  --help             print this usage message" << "\n"
 	;
 	if(wrapper.empty()) {
-		cerr << endl
-		     << "*** Warning ***" << endl
+		cerr << "\n"
+		     << "*** Warning ***" << "\n"
 			 << "'boowtie2-inspect' was run directly.  It is recommended "
 			 << "to use the wrapper script instead."
-			 << endl << endl;
+			 << "\n" << "\n";
 	}
 }
 
 /**
  * Parse an int out of optarg and enforce that it be at least 'lower';
- * if it is less than 'lower', than output the given error message and
- * exit with an error and a usage message.
+ * if it is malformed or less than 'lower', then output the given error
+ * message and exit with an error and a usage message.
  */
 static int parseInt(int lower, const char *errmsg) {
-	long l;
-	char *endPtr= NULL;
-	l = strtol(optarg, &endPtr, 10);
-	if (endPtr != NULL) {
-		if (l < lower) {
-			cerr << errmsg << endl;
-			printUsage(cerr);
-			throw 1;
-		}
-		return (int32_t)l;
+	// The old strtol version tested 'endPtr != NULL', which strtol
+	// guarantees, so malformed arguments were silently accepted as 0;
+	// from_chars lets us reject anything that isn't entirely a number
+	int v = 0;
+	const char *end = optarg + strlen(optarg);
+	std::from_chars_result r = std::from_chars(optarg, end, v);
+	if (r.ec != std::errc() || r.ptr != end || v < lower) {
+		cerr << errmsg << endl;
+		printUsage(cerr);
+		throw 1;
 	}
-	cerr << errmsg << endl;
-	printUsage(cerr);
-	throw 1;
-	return -1;
+	return v;
 }
 
 /**
@@ -151,36 +156,112 @@ static void parseOptions(int argc, char **argv) {
 	} while(next_option != -1);
 }
 
-static void print_fasta_record(
-	ostream& fout,
-	const string& defline,
-	const string& seq)
-{
-	fout << ">";
-	fout << defline.c_str() << endl;
+/**
+ * Append the decimal form of 'val' to 'out'.  std::to_chars is locale-
+ * free and much cheaper than the num_put machinery behind operator<<.
+ */
+template<typename T>
+static void append_int(string& out, T val) {
+	char tmp[32];
+	std::to_chars_result r = std::to_chars(tmp, tmp + sizeof(tmp), val);
+	out.append(tmp, r.ptr);
+}
 
-	if(across > 0) {
-		size_t i = 0;
-		while (i + across < seq.length())
-		{
-			fout << seq.substr(i, across).c_str() << endl;
-			i += across;
+/**
+ * Buffered FASTA writer that wraps lines at 'across' columns as bases
+ * arrive, so callers never have to materialize a whole reference
+ * sequence before printing it.  Whether wrapping happens at all is a
+ * template parameter so the per-base emit path carries no dead branch
+ * in the unwrapped (-a 0) case, and common widths can additionally be
+ * baked in as the 'Across' parameter (0 = use the runtime width) so
+ * the wrap comparison is against a literal.
+ */
+template<bool Newlines, int Across = 0>
+class FastaEmitter {
+public:
+	FastaEmitter(FILE* fout, int across) :
+		fout_(fout),
+		across_(across > 0 ? (size_t)across : 0),
+		col_(0),
+		emitted_(0)
+	{
+		assert_eq(Newlines, across > 0);
+		assert(Across == 0 || Across == across);
+		buf_.reserve(1 << 16);
+	}
+
+	~FastaEmitter() { flush(); }
+
+	/// Start a new FASTA record with the given defline
+	void beginRecord(const string& defline) {
+		buf_.push_back('>');
+		buf_.insert(buf_.end(), defline.begin(), defline.end());
+		buf_.push_back('\n');
+		col_ = 0;
+		emitted_ = 0;
+		maybeFlush();
+	}
+
+	/// Append one base, wrapping the line if we hit the column limit
+	void emitBase(char c) {
+		buf_.push_back(c);
+		emitted_++;
+		if(Newlines && ++col_ == width()) {
+			buf_.push_back('\n');
+			col_ = 0;
+			maybeFlush();
 		}
-		if (i < seq.length())
-			fout << seq.substr(i).c_str() << endl;
-	} else {
-		fout << seq.c_str() << endl;
 	}
-}
+
+	/// Append a run of Ns, e.g. for gaps between reference fragments
+	void emitNs(size_t n) {
+		for(size_t i = 0; i < n; i++) emitBase('N');
+	}
+
+	/// Finish the current record, terminating any partial final line
+	void endRecord() {
+		if(!Newlines || col_ > 0) buf_.push_back('\n');
+		col_ = 0;
+		maybeFlush();
+	}
+
+	/// Number of bases emitted for the current record
+	size_t emitted() const { return emitted_; }
+
+	void flush() {
+		if(!buf_.empty()) {
+			fwrite(buf_.data(), 1, buf_.size(), fout_);
+			buf_.clear();
+		}
+	}
+
+private:
+	/// Line width; a compile-time constant when Across > 0
+	size_t width() const {
+		return Across > 0 ? (size_t)Across : across_;
+	}
+
+	void maybeFlush() {
+		if(buf_.size() >= (1 << 15)) flush();
+	}
+
+	FILE* fout_;
+	size_t across_;
+	size_t col_;
+	size_t emitted_;
+	std::vector<char> buf_;
+};
 
 /**
- * Given output stream, BitPairReference, reference index, name and
- * length, print the whole nucleotide reference with the appropriate
- * number of columns.
+ * Given a BitPairReference, reference index, name and length, append
+ * the whole nucleotide reference with the appropriate number of
+ * columns to 'dst'.  Appending to a caller-owned buffer (rather than
+ * writing a stream) keeps this reentrant, so distinct references can
+ * be rendered concurrently.
  */
 static void print_ref_sequence(
-	ostream& fout,
-	BitPairReference& ref,
+	string& dst,
+	const BitPairReference& ref,
 	const string& name,
 	size_t refi,
 	size_t len)
@@ -188,31 +269,79 @@ static void print_ref_sequence(
 	bool newlines = across > 0;
 	int myacross = across > 0 ? across : 60;
 	size_t incr = myacross * 1000;
-	uint32_t *buf = new uint32_t[(incr + 128)/4];
-	fout << ">" << name.c_str() << "\n";
+	// 64-byte aligned, with the existing 128 bytes of slack rounded up
+	// to a whole cacheline, so the vector loads/stores and prefetches
+	// in the translation loop never touch unowned memory
+	size_t bufBytes = (incr + 128 + 63) & ~(size_t)63;
+	std::unique_ptr<uint32_t[], void(*)(void*)> buf(
+		static_cast<uint32_t*>(std::aligned_alloc(64, bufBytes)),
+		std::free);
+	if(buf == NULL) {
+		throw std::bad_alloc();
+	}
+	// Translate each stretch into ASCII in a flat scratch buffer, then
+	// append it to 'dst' line by line
+	std::vector<char> xlat(incr);
+	dst.reserve(dst.length() + len + len/myacross + name.length() + 3);
+	dst.push_back('>');
+	dst.append(name);
+	dst.push_back('\n');
 	ASSERT_ONLY(SStringExpandable<uint32_t> destU32);
 	for(size_t i = 0; i < len; i += incr) {
 		size_t amt = min(incr, len-i);
 		assert_leq(amt, incr);
-		int off = ref.getStretch(buf, refi, i, amt ASSERT_ONLY(, destU32));
-		uint8_t *cb = ((uint8_t*)buf) + off;
-		for(size_t j = 0; j < amt; j++) {
-			if(newlines && j > 0 && (j % myacross) == 0) fout << "\n";
+		int off = ref.getStretch(buf.get(), refi, i, amt ASSERT_ONLY(, destU32));
+		uint8_t *cb = ((uint8_t*)buf.get()) + off;
+		// Start pulling the next stretch's packed bytes toward the
+		// cache while we translate this one
+		if(i + incr < len) ref.prefetchStretch(refi, i + incr);
+		size_t j = 0;
+#ifdef __AVX2__
+		// vpshufb maps each base code (0-4) to its ASCII character, 32
+		// bases per iteration; the LUT is duplicated in both 128-bit
+		// lanes since the shuffle is lane-local
+		const __m256i lut = _mm256_setr_epi8(
+			'A','C','G','T','N',0,0,0,0,0,0,0,0,0,0,0,
+			'A','C','G','T','N',0,0,0,0,0,0,0,0,0,0,0);
+		for(; j + 32 <= amt; j += 32) {
+			if((j & 63) == 0) __builtin_prefetch(cb + j + 512);
+			__m256i v = _mm256_loadu_si256((const __m256i*)(cb + j));
+			__m256i a = _mm256_shuffle_epi8(lut, v);
+			_mm256_storeu_si256((__m256i*)(xlat.data() + j), a);
+		}
+#endif
+		for(; j < amt; j++) {
+			if((j & 63) == 0) __builtin_prefetch(cb + j + 512);
 			assert_range(0, 4, (int)cb[j]);
-			fout << "ACGTN"[(int)cb[j]];
+			xlat[j] = "ACGTN"[(int)cb[j]];
+		}
+		// Chunk boundaries fall on line boundaries because incr is a
+		// multiple of myacross, so newlines go every myacross chars
+		// plus one after the (possibly partial) final line
+		if(newlines) {
+			for(size_t l = 0; l < amt; l += myacross) {
+				size_t n = min((size_t)myacross, amt - l);
+				dst.append(xlat.data() + l, n);
+				dst.push_back('\n');
+			}
+		} else {
+			dst.append(xlat.data(), amt);
+			dst.push_back('\n');
 		}
-		fout << "\n";
 	}
-	delete [] buf;
 }
 
 /**
  * Create a BitPairReference encapsulating the reference portion of the
  * index at the given basename.  Iterate through the reference
- * sequences, sending each one to print_ref_sequence to print.
+ * sequences, sending each one to print_ref_sequence to print.  With
+ * OpenMP enabled, references are rendered in parallel into per-
+ * reference buffers and written out in index order; getStretch only
+ * reads shared state, so concurrent calls on distinct references are
+ * safe.
  */
 static void print_ref_sequences(
-	ostream& fout,
+	FILE* fout,
 	bool color,
 	const EList<string>& refnames,
 	const TIndexOffU* plen,
@@ -231,30 +360,57 @@ static void print_ref_sequences(
 		verbose,              // be talkative
 		verbose);             // be talkative at startup
 	assert_eq(ref.numRefs(), refnames.size());
+#ifdef _OPENMP
+	std::vector<string> outs(ref.numRefs());
+	#pragma omp parallel for schedule(dynamic,1)
+	for(size_t i = 0; i < ref.numRefs(); i++) {
+		print_ref_sequence(
+			outs[i],
+			ref,
+			refnames[i],
+			i,
+			plen[i] + (color ? 1 : 0));
+	}
+	for(size_t i = 0; i < outs.size(); i++) {
+		fwrite(outs[i].data(), 1, outs[i].length(), fout);
+	}
+#else
+	string out;
 	for(size_t i = 0; i < ref.numRefs(); i++) {
+		out.clear();
 		print_ref_sequence(
-			fout,
+			out,
 			ref,
 			refnames[i],
 			i,
 			plen[i] + (color ? 1 : 0));
+		fwrite(out.data(), 1, out.length(), fout);
 	}
+#endif
 }
 
 /**
  * Given an index, reconstruct the reference by LF mapping through the
- * entire thing.
+ * entire thing.  'Newlines' mirrors whether across > 0 so the per-base
+ * loop is compiled without the wrap test when output is unwrapped;
+ * 'Across' bakes in the column width for common values.
  */
-template<typename TStr>
-static void print_index_sequences(ostream& fout, Ebwt& ebwt)
+template<typename TStr, bool Newlines, int Across>
+static void print_index_sequences_impl(FILE* fout, Ebwt& ebwt)
 {
 	EList<string>* refnames = &(ebwt.refnames());
 
 	TStr cat_ref;
 	ebwt.restore(cat_ref);
 
+	// Stream each base straight to the (buffered) output as it is
+	// decoded; no per-reference sequence is ever held in memory
+	FastaEmitter<Newlines, Across> emitter(fout, across);
+	// Joined offsets are visited in increasing order, so a cursor that
+	// walks the rstarts fragments amortizes the per-base lookup to
+	// O(1) instead of a binary search per base
+	JoinedCursor cursor(ebwt);
 	TIndexOffU curr_ref = OFF_MASK;
-	string curr_ref_seq = "";
 	TIndexOffU curr_ref_len = OFF_MASK;
 	TIndexOffU last_text_off = 0;
 	size_t orig_len = cat_ref.length();
@@ -264,8 +420,7 @@ static void print_index_sequences(ostream& fout, Ebwt& ebwt)
 		TIndexOffU tidx = OFF_MASK;
 		TIndexOffU textoff = OFF_MASK;
 		tlen = OFF_MASK;
-		bool straddled = false;
-		ebwt.joinedToTextOff(1 /* qlen */, (TIndexOffU)i, tidx, textoff, tlen, true, straddled);
+		cursor.resolve((TIndexOffU)i, tidx, textoff, tlen);
 
 		if (tidx != OFF_MASK && textoff < tlen)
 		{
@@ -274,14 +429,14 @@ static void print_index_sequences(ostream& fout, Ebwt& ebwt)
 				if (curr_ref != OFF_MASK)
 				{
 					// Add trailing gaps, if any exist
-					if(curr_ref_seq.length() < curr_ref_len) {
-						curr_ref_seq += string(curr_ref_len - curr_ref_seq.length(), 'N');
+					if(emitter.emitted() < curr_ref_len) {
+						emitter.emitNs(curr_ref_len - emitter.emitted());
 					}
-					print_fasta_record(fout, (*refnames)[curr_ref], curr_ref_seq);
+					emitter.endRecord();
 				}
 				curr_ref = tidx;
-				curr_ref_seq = "";
 				curr_ref_len = tlen;
+				emitter.beginRecord((*refnames)[curr_ref]);
 				last_text_off = 0;
 				first = true;
 			}
@@ -289,9 +444,9 @@ static void print_index_sequences(ostream& fout, Ebwt& ebwt)
 			TIndexOffU textoff_adj = textoff;
 			if(first && textoff > 0) textoff_adj++;
 			if (textoff_adj - last_text_off > 1)
-				curr_ref_seq += string(textoff_adj - last_text_off - 1, 'N');
+				emitter.emitNs(textoff_adj - last_text_off - 1);
 
-			curr_ref_seq.push_back("ACGT"[int(cat_ref[i])]);
+			emitter.emitBase("ACGT"[int(cat_ref[i])]);
 			last_text_off = textoff;
 			first = false;
 		}
@@ -299,23 +454,44 @@ static void print_index_sequences(ostream& fout, Ebwt& ebwt)
 	if (curr_ref < refnames->size())
 	{
 		// Add trailing gaps, if any exist
-		if(curr_ref_seq.length() < curr_ref_len) {
-			curr_ref_seq += string(curr_ref_len - curr_ref_seq.length(), 'N');
+		if(emitter.emitted() < curr_ref_len) {
+			emitter.emitNs(curr_ref_len - emitter.emitted());
 		}
-		print_fasta_record(fout, (*refnames)[curr_ref], curr_ref_seq);
+		emitter.endRecord();
 	}
+}
 
+/**
+ * Dispatch to the right print_index_sequences_impl specialization for
+ * the configured column width.
+ */
+template<typename TStr>
+static void print_index_sequences(FILE* fout, Ebwt& ebwt)
+{
+	switch(across) {
+		case 60: print_index_sequences_impl<TStr, true, 60>(fout, ebwt); break;
+		case 80: print_index_sequences_impl<TStr, true, 80>(fout, ebwt); break;
+		default:
+			if(across > 0) {
+				print_index_sequences_impl<TStr, true, 0>(fout, ebwt);
+			} else {
+				print_index_sequences_impl<TStr, false, 0>(fout, ebwt);
+			}
+	}
 }
 
 static char *argv0 = NULL;
 
-static void print_index_sequence_names(const string& fname, ostream& fout)
+static void print_index_sequence_names(const string& fname, FILE* fout)
 {
 	EList<string> p_refnames;
 	readEbwtRefnames(fname, p_refnames);
+	string out;
 	for(size_t i = 0; i < p_refnames.size(); i++) {
-		cout << p_refnames[i].c_str() << endl;
+		out.append(p_refnames[i]);
+		out.push_back('\n');
 	}
+	fwrite(out.data(), 1, out.length(), fout);
 }
 
 /**
@@ -323,7 +499,7 @@ static void print_index_sequence_names(const string& fname, ostream& fout)
  */
 static void print_index_summary(
 	const string& fname,
-	ostream& fout)
+	FILE* fout)
 {
 	int32_t flags = Ebwt::readFlags(fname);
 	int32_t flagsr = Ebwt::readFlags(fname + ".rev");
@@ -347,20 +523,59 @@ static void print_index_summary(
 		verbose,              // be talkative at startup?
 		false,                // pass up memory exceptions?
 		false);               // sanity check?
-	EList<string> p_refnames;
-	readEbwtRefnames(fname, p_refnames);
-	cout << "Flags" << '\t' << (-flags) << endl;
-	cout << "Reverse flags" << '\t' << (-flagsr) << endl;
-	cout << "2.0-compatible" << '\t' << (entireReverse ? "1" : "0") << endl;
-	cout << "SA-Sample" << "\t1 in " << (1 << ebwt.eh().offRate()) << endl;
-	cout << "FTab-Chars" << '\t' << ebwt.eh().ftabChars() << endl;
+	// Reuse the primary stream the Ebwt constructor already has open
+	// rather than re-opening and re-parsing the .1 file
+	EList<string>& p_refnames = ebwt.loadRefnames();
+	// Accumulate the whole summary and write it once, rather than
+	// paying an operator<< (and a flush, for endl) per field; on
+	// many-contig indexes each endl was a separate write syscall
+	string out;
+	out.reserve(64 * p_refnames.size() + 128);
+	out.append("Flags\t");
+	append_int(out, -flags);
+	out.push_back('\n');
+	out.append("Reverse flags\t");
+	append_int(out, -flagsr);
+	out.push_back('\n');
+	out.append("2.0-compatible\t");
+	out.append(entireReverse ? "1" : "0");
+	out.push_back('\n');
+	out.append("SA-Sample\t1 in ");
+	append_int(out, 1 << ebwt.eh().offRate());
+	out.push_back('\n');
+	out.append("FTab-Chars\t");
+	append_int(out, ebwt.eh().ftabChars());
+	out.push_back('\n');
 	assert_eq(ebwt.nPat(), p_refnames.size());
-	for(size_t i = 0; i < p_refnames.size(); i++) {
-		cout << "Sequence-" << (i+1)
-		     << '\t' << p_refnames[i].c_str()
-		     << '\t' << (ebwt.plen()[i] + (color ? 1 : 0))
-		     << endl;
+	// Pack the per-sequence fields into flat arrays -- names end-to-end
+	// in one pool plus offset/length/plen arrays -- so the emit sweep
+	// below is a linear scan instead of a per-contig chase through
+	// EList and string headers
+	size_t nref = p_refnames.size();
+	string name_pool;
+	std::vector<size_t> name_off(nref), name_len(nref);
+	std::vector<TIndexOffU> plens(nref);
+	size_t pool_len = 0;
+	for(size_t i = 0; i < nref; i++) {
+		pool_len += p_refnames[i].length();
+	}
+	name_pool.reserve(pool_len);
+	for(size_t i = 0; i < nref; i++) {
+		name_off[i] = name_pool.length();
+		name_len[i] = p_refnames[i].length();
+		name_pool.append(p_refnames[i]);
+		plens[i] = ebwt.plen()[i] + (color ? 1 : 0);
 	}
+	for(size_t i = 0; i < nref; i++) {
+		out.append("Sequence-");
+		append_int(out, i+1);
+		out.push_back('\t');
+		out.append(name_pool.data() + name_off[i], name_len[i]);
+		out.push_back('\t');
+		append_int(out, plens[i]);
+		out.push_back('\n');
+	}
+	fwrite(out.data(), 1, out.length(), fout);
 }
 
 static void driver(
@@ -371,14 +586,15 @@ static void driver(
 	string adjustedEbwtFileBase = adjustEbwtBase(argv0, ebwtFileBase, verbose);
 
 	if (names_only) {
-		print_index_sequence_names(adjustedEbwtFileBase, cout);
+		print_index_sequence_names(adjustedEbwtFileBase, stdout);
 	} else if(summarize_only) {
-		print_index_summary(adjustedEbwtFileBase, cout);
-	} else {
-		// Initialize Ebwt object
+		print_index_summary(adjustedEbwtFileBase, stdout);
+	} else if(refFromEbwt) {
+		// Initialize Ebwt object; the LF-mapping reconstruction needs
+		// the whole index, so ask for everything
 		bool color = readEbwtColor(adjustedEbwtFileBase);
 		Ebwt ebwt(
-			adjustedEbwtFileBase, 
+			adjustedEbwtFileBase,
 			color,                // index is colorspace
 			-1,                   // don't care about entire-reverse
 			true,                 // index is for the forward direction
@@ -396,30 +612,48 @@ static void driver(
 			false,                // pass up memory exceptions?
 			false);               // sanity check?
 		// Load whole index into memory
-		if(refFromEbwt) {
-			ebwt.loadIntoMemory(
-				-1,     // color
-				-1,     // need entire reverse
-				true,   // load SA sample
-				true,   // load ftab
-				true,   // load rstarts
-				true,   // load names
-				false); // verbose
-			print_index_sequences<SString<char> >(cout, ebwt);
-		} else {
-			EList<string> refnames;
-			readEbwtRefnames(adjustedEbwtFileBase, refnames);
-			print_ref_sequences(
-				cout,
-				readEbwtColor(ebwtFileBase),
-				refnames,
-				ebwt.plen(),
-				adjustedEbwtFileBase);
-		}
+		ebwt.loadIntoMemory(
+			-1,     // color
+			-1,     // need entire reverse
+			true,   // load SA sample
+			true,   // load ftab
+			true,   // load rstarts
+			true,   // load names
+			false); // verbose
+		print_index_sequences<SString<char> >(stdout, ebwt);
 		// Evict any loaded indexes from memory
 		if(ebwt.isInMemory()) {
 			ebwt.evictFromMemory();
 		}
+	} else {
+		// The BitPairReference path only needs the header (for plen)
+		// and the reference names, so don't ask for the SA sample,
+		// ftab or rstarts
+		bool color = readEbwtColor(adjustedEbwtFileBase);
+		Ebwt ebwt(
+			adjustedEbwtFileBase,
+			color,                // index is colorspace
+			-1,                   // don't care about entire-reverse
+			true,                 // index is for the forward direction
+			-1,                   // offrate (-1 = index default)
+			0,                    // offrate-plus (0 = index default)
+			false,                // use memory-mapped IO
+			false,                // use shared memory
+			false,                // sweep memory-mapped memory
+			true,                 // load names?
+			false,                // load SA sample?
+			false,                // load ftab?
+			false,                // load rstarts?
+			verbose,              // be talkative?
+			verbose,              // be talkative at startup?
+			false,                // pass up memory exceptions?
+			false);               // sanity check?
+		print_ref_sequences(
+			stdout,
+			readEbwtColor(ebwtFileBase),
+			ebwt.loadRefnames(),
+			ebwt.plen(),
+			adjustedEbwtFileBase);
 	}
 }
 
@@ -428,6 +662,12 @@ static void driver(
  */
 int main(int argc, char **argv) {
 	try {
+		// Bulk output is written straight to stdout with fwrite; give
+		// stdio a big buffer so flushes are rare.  cout (usage/version/
+		// verbose messages) stays synchronized with stdio, so the two
+		// can't interleave badly.
+		static char sbuf[1 << 20];
+		setvbuf(stdout, sbuf, _IOFBF, sizeof sbuf);
 		string ebwtFile;  // read serialized Ebwt from this file
 		string query;   // read query string(s) from this file
 		EList<string> queries;
@@ -435,23 +675,23 @@ int main(int argc, char **argv) {
 		argv0 = argv[0];
 		parseOptions(argc, argv);
 		if(showVersion) {
-			cout << argv0 << " version " << BOWTIE2_VERSION << endl;
+			cout << argv0 << " version " << BOWTIE2_VERSION << "\n";
 			if(sizeof(void*) == 4) {
-				cout << "32-bit" << endl;
+				cout << "32-bit" << "\n";
 			} else if(sizeof(void*) == 8) {
-				cout << "64-bit" << endl;
+				cout << "64-bit" << "\n";
 			} else {
-				cout << "Neither 32- nor 64-bit: sizeof(void*) = " << sizeof(void*) << endl;
+				cout << "Neither 32- nor 64-bit: sizeof(void*) = " << sizeof(void*) << "\n";
 			}
-			cout << "Built on " << BUILD_HOST << endl;
-			cout << BUILD_TIME << endl;
-			cout << "Compiler: " << COMPILER_VERSION << endl;
-			cout << "Options: " << COMPILER_OPTIONS << endl;
+			cout << "Built on " << BUILD_HOST << "\n";
+			cout << BUILD_TIME << "\n";
+			cout << "Compiler: " << COMPILER_VERSION << "\n";
+			cout << "Options: " << COMPILER_OPTIONS << "\n";
 			cout << "Sizeof {int, long, long long, void*, size_t, off_t}: {"
 				 << sizeof(int)
 				 << ", " << sizeof(long) << ", " << sizeof(long long)
 				 << ", " << sizeof(void *) << ", " << sizeof(size_t)
-				 << ", " << sizeof(off_t) << "}" << endl;
+				 << ", " << sizeof(off_t) << "}" << "\n";
 			return 0;
 		}
 
@@ -465,13 +705,13 @@ int main(int argc, char **argv) {
 
 		// Optionally summarize
 		if(verbose) {
-			cout << "Input ebwt file: \"" << ebwtFile.c_str() << "\"" << endl;
-			cout << "Output file: \"" << outfile.c_str() << "\"" << endl;
-			cout << "Local endianness: " << (currentlyBigEndian()? "big":"little") << endl;
+			cout << "Input ebwt file: \"" << ebwtFile.c_str() << "\"" << "\n";
+			cout << "Output file: \"" << outfile.c_str() << "\"" << "\n";
+			cout << "Local endianness: " << (currentlyBigEndian()? "big":"little") << "\n";
 #ifdef NDEBUG
-			cout << "Assertions: disabled" << endl;
+			cout << "Assertions: disabled" << "\n";
 #else
-			cout << "Assertions: enabled" << endl;
+			cout << "Assertions: enabled" << "\n";
 #endif
 		}
 		driver(ebwtFile, query);
@@ -19,6 +19,7 @@
 
 #include <string>
 #include <string.h>
+#include <fcntl.h>
 #include "reference.h"
 #include "mem_ids.h"
 
@@ -64,6 +65,13 @@ BitPairReference::BitPairReference(
 		loaded_ = false;
 		return;
 	}
+#if defined(POSIX_FADV_SEQUENTIAL) && defined(POSIX_FADV_WILLNEED)
+	// Both files are read front to back; tell the kernel so it can
+	// read ahead aggressively and start faulting in the packed
+	// reference right away
+	posix_fadvise(fileno(f3), 0, 0, POSIX_FADV_SEQUENTIAL);
+	posix_fadvise(fileno(f4), 0, 0, POSIX_FADV_SEQUENTIAL | POSIX_FADV_WILLNEED);
+#endif
 #ifdef BOWTIE_MM
     char *mmFile = NULL;
 	if(useMm_) {
@@ -84,6 +92,9 @@ BitPairReference::BitPairReference(
 			cerr << "Error: Could not memory-map the index file " << s4.c_str() << endl;
 			throw 1;
 		}
+#ifdef MADV_SEQUENTIAL
+		madvise(mmFile, (size_t)sbuf.st_size, MADV_SEQUENTIAL | MADV_WILLNEED);
+#endif
 		if(mmSweep) {
 			TIndexOff sum = 0;
 			for(off_t i = 0; i < sbuf.st_size; i += 1024) {
@@ -223,6 +234,9 @@ BitPairReference::BitPairReference(
 				loaded_ = false;
 				return;
 			}
+#if defined(POSIX_FADV_SEQUENTIAL) && defined(POSIX_FADV_WILLNEED)
+			posix_fadvise(fileno(f4), 0, 0, POSIX_FADV_SEQUENTIAL | POSIX_FADV_WILLNEED);
+#endif
 			// Read the whole thing in
 			size_t ret = fread(buf_, 1, cumsz >> 2, f4);
 			// Didn't read all of it?
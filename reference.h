@@ -115,6 +115,23 @@ public:
 		size_t count
 		ASSERT_ONLY(, SStringExpandable<uint32_t>& destU32_2)) const;
 
+	/**
+	 * Issue cache-prefetch hints for the packed reference data that an
+	 * upcoming getStretch(tidx, toff, ...) call will read.  The byte
+	 * position is approximate -- ambiguous positions are not stored in
+	 * buf_, so the true offset is at most (toff >> 2) bytes in -- but
+	 * that is fine for a hint.  No-op if the reference isn't loaded.
+	 */
+	void prefetchStretch(size_t tidx, size_t toff) const {
+		if(buf_ == NULL || tidx >= nrefs_) return;
+		size_t bytePos = (size_t)((refOffs_[tidx] + toff) >> 2);
+		size_t byteSz = (size_t)(bufSz_ >> 2);
+		for(int i = 0; i < 8; i++) {
+			if(bytePos + (size_t)(i * 64) >= byteSz) break;
+			__builtin_prefetch(buf_ + bytePos + i * 64, 0 /* read */, 0 /* low locality */);
+		}
+	}
+
 	/**
 	 * Return the number of reference sequences.
 	 */